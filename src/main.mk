@@ -103,6 +103,7 @@ SOURCES      := AS_global.C \
                 utgcns/libcns/abAbacus.C \
                 utgcns/libcns/abColumn.C \
                 utgcns/libcns/abMultiAlign.C \
+                utgcns/libcns/cnsReadSet.C \
                 utgcns/libcns/unitigConsensus.C \
                 utgcns/libpbutgcns/AlnGraphBoost.C  \
                 \
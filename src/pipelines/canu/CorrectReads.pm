@@ -200,6 +200,7 @@ sub buildCorrectionLayouts_direct ($) {
         $cmd .= "  -T ../$asm.corStore 1 \\\n";
         $cmd .= "  -o ./correction_inputs/ \\\n";
         $cmd .= "  -p " . $jobs . " \\\n";
+        $cmd .= "  -B \\\n";
         $cmd .= "> ./correction_inputs.err 2>&1";
 
         if (runCommand($path, $cmd)) {
@@ -454,7 +455,7 @@ sub buildCorrectionLayouts_piped ($) {
     print F "  -E " . getGlobal("corMaxEvidenceErate")  . " \\\n"  if (defined(getGlobal("corMaxEvidenceErate")));
     print F "  -C $maxCov \\\n"                                    if (defined($maxCov));
     print F "  -legacy \\\n"                                       if (defined(getGlobal("corLegacyFilter")));
-    print F "  -F \\\n";
+    print F "  -B \\\n";
     print F "&& \\\n";
     print F "  touch ./correction_outputs/\$jobid.dump.success \\\n";
     print F ") \\\n";
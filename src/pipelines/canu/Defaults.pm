@@ -866,7 +866,7 @@ sub setDefaults () {
 
     ##### Overlap Store
 
-    setDefault("ovsMethod", undef, "Use the 'sequential' or 'parallel' algorithm for constructing an overlap store; default 'sequential'");
+    setDefault("ovsMethod", undef, "Use the 'sequential', 'streaming' or 'parallel' algorithm for constructing an overlap store; default 'sequential'");
 
     #####  Mers
 
@@ -1265,8 +1265,9 @@ sub checkParameters () {
     }
 
     if ((getGlobal("ovsMethod") ne "sequential") &&
+        (getGlobal("ovsMethod") ne "streaming") &&
         (getGlobal("ovsMethod") ne "parallel")) {
-        addCommandLineError("ERROR:  Invalid 'ovsMethod' specified (" . getGlobal("ovsMethod") . "); must be 'sequential' or 'parallel'\n");
+        addCommandLineError("ERROR:  Invalid 'ovsMethod' specified (" . getGlobal("ovsMethod") . "); must be 'sequential', 'streaming' or 'parallel'\n");
     }
     if ((getGlobal("useGrid")   eq "0") &&
         (getGlobal("ovsMethod") eq "parallel")) {
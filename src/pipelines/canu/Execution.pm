@@ -680,7 +680,8 @@ sub submitScript ($$) {
 
     #  However, the sequential overlap store is still built from within the canu process.
 
-    if (getGlobal("ovsMethod") eq "sequential") {
+    if ((getGlobal("ovsMethod") eq "sequential") ||
+        (getGlobal("ovsMethod") eq "streaming")) {
         $mem = getGlobal("ovsMemory");
         $mem = $2  if ($mem =~ m/^(\d+)-(\d+)$/);
     }
@@ -438,12 +438,16 @@ sub merylConfigure ($$) {
     print F "&& \\\n";
     print F "mv ./$ofile.WORKING.mcdat ./$ofile.mcdat \\\n";
     print F "&& \\\n";
-    print F "mv ./$ofile.WORKING.mcidx ./$ofile.mcidx\n";
+    print F "mv ./$ofile.WORKING.mcidx ./$ofile.mcidx \\\n";
+    print F "&& \\\n";
+    print F "mv ./$ofile.WORKING.mcrai ./$ofile.mcrai\n";
     print F "\n";
     print F stashFileShellCode("$path", "$ofile.mcdat", "");
     print F "\n";
     print F stashFileShellCode("$path", "$ofile.mcidx", "");
     print F "\n";
+    print F stashFileShellCode("$path", "$ofile.mcrai", "");
+    print F "\n";
     print F "\n";
     print F "#  Dump a histogram\n";
     print F "\n";
@@ -625,6 +629,7 @@ sub merylProcess ($$) {
     if (getGlobal("${tag}Overlapper") eq "ovl") {
         fetchFile("$path/$ofile.mcdat");
         fetchFile("$path/$ofile.mcidx");
+        fetchFile("$path/$ofile.mcrai");
 
         if ((! -e "$path/$ofile.mcdat") ||
             (! -e "$path/$ofile.mcdat")) {
@@ -694,6 +699,7 @@ sub merylProcess ($$) {
 
         fetchFile("$path/$ofile.mcdat");
         fetchFile("$path/$ofile.mcidx");
+        fetchFile("$path/$ofile.mcrai");
 
         open(F, "$bin/meryl -Dt -n $minCount -s $path/$ofile | ")    or die "Failed to run meryl to generate frequent mers $!\n";
         open(O, "| gzip -c > $path/$ofile.frequentMers.ignore.gz")   or die "Failed to open '$path/$ofile.frequentMers.ignore.gz' for writing: $!\n";
@@ -763,6 +769,7 @@ sub merylProcess ($$) {
 
     unlink "$path/$ofile.mcidx"   if (getGlobal("saveMerCounts") == 0);
     unlink "$path/$ofile.mcdat"   if (getGlobal("saveMerCounts") == 0);
+    unlink "$path/$ofile.mcrai"   if (getGlobal("saveMerCounts") == 0);
 
     emitStage($asm, "$tag-meryl");
     buildHTML($asm, $tag);
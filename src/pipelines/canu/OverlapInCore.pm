@@ -227,6 +227,7 @@ sub overlapConfigure ($$$) {
         print F "\n";
         print F stashFileShellCode("$base/1-overlapper/", "\$job.ovb", "");
         print F stashFileShellCode("$base/1-overlapper/", "\$job.counts", "");
+        print F stashFileShellCode("$base/1-overlapper/", "\$job.blocks", "");
         print F stashFileShellCode("$base/1-overlapper/", "\$job.stats", "");
         print F "\n";
         print F "exit 0\n";
@@ -376,6 +377,7 @@ sub overlapCheck ($$$) {
                 push @statsJobs,   "1-overlapper/$1.stats";
                 push @miscJobs,    "1-overlapper/$1.stats\n";
                 push @miscJobs,    "1-overlapper/$1.counts\n";
+                push @miscJobs,    "1-overlapper/$1.blocks\n";
 
             } elsif (fileExists("$path/$1.ovb.bz2")) {
                 push @successJobs, "1-overlapper/$1.ovb.bz2\n";
@@ -727,6 +727,7 @@ sub mhapCheck ($$$) {
                 push @successJobs, "1-overlapper/results/$1.ovb\n";
                 push @miscJobs,    "1-overlapper/results/$1.stats\n";
                 push @miscJobs,    "1-overlapper/results/$1.counts\n";
+                push @miscJobs,    "1-overlapper/results/$1.blocks\n";
 
             } elsif (fileExists("$path/results/$1.ovb.bz2")) {
                 push @mhapJobs,    "1-overlapper/results/$1.mhap\n";
@@ -62,10 +62,11 @@ use canu::Grid_Cloud;
 #  NOT FILTERING overlaps by error rate when building the parallel store.
 
 
-sub createOverlapStoreSequential ($$$) {
+sub createOverlapStoreSequential ($$$$) {
     my $base    = shift @_;
     my $asm     = shift @_;
     my $tag     = shift @_;
+    my $stream  = shift @_;
     my $bin     = getBinDirectory();
     my $cmd;
 
@@ -98,6 +99,8 @@ sub createOverlapStoreSequential ($$$) {
     $cmd .= " -O ./$asm.ovlStore.BUILDING \\\n";
     $cmd .= " -G ./$asm.gkpStore \\\n";
     $cmd .= " -M $memSize \\\n";
+    $cmd .= " -threads " . getGlobal("ovsThreads") . " \\\n";
+    $cmd .= " -stream \\\n"  if ($stream);
     $cmd .= " -L ./1-overlapper/ovljob.files \\\n";
     $cmd .= " > ./$asm.ovlStore.err 2>&1";
 
@@ -317,6 +320,7 @@ sub overlapStoreConfigure ($$$) {
         print F "\$bin/ovStoreSorter \\\n";
         print F "  -deletelate \\\n";  #  Choices -deleteearly -deletelate or nothing
         print F "  -M $memLimit \\\n";
+        print F "  -threads " . getGlobal("ovsThreads") . " \\\n";
         print F "  -O . \\\n";
         print F "  -G ../$asm.gkpStore \\\n";
         print F "  -F $numSlices \\\n";
@@ -658,8 +662,9 @@ sub createOverlapStore ($$$) {
 
     #  Then just build the store!  Simple!
 
-    createOverlapStoreSequential($base, $asm, $tag)  if ($seq eq "sequential");
-    createOverlapStoreParallel  ($base, $asm, $tag)  if ($seq eq "parallel");
+    createOverlapStoreSequential($base, $asm, $tag, 0)  if ($seq eq "sequential");
+    createOverlapStoreSequential($base, $asm, $tag, 1)  if ($seq eq "streaming");
+    createOverlapStoreParallel  ($base, $asm, $tag)     if ($seq eq "parallel");
 
     checkOverlapStore($base, $asm);
 
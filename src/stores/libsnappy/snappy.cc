@@ -137,6 +137,11 @@ namespace {
 
 const int kMaxIncrementCopyOverflow = 10;
 
+// GCC's loop vectorizer turns the eight-byte copies below into sixteen-byte
+// copies, which breaks the pattern expansion when op - src is between 8 and 15.
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((optimize("no-tree-vectorize")))
+#endif
 inline void IncrementalCopyFastPath(const char* src, char* op, ssize_t len) {
   while (PREDICT_FALSE(op - src < 8)) {
     UnalignedCopy64(src, op);
@@ -8,7 +8,7 @@ ifeq "$(strip ${TARGET_DIR})" ""
 endif
 
 TARGET   := utgcns
-SOURCES  := utgcns.C stashContains.C
+SOURCES  := utgcns.C stashContains.C cnsPackage.C
 
 SRC_INCDIRS  := .. ../AS_UTL ../stores libcns libpbutgcns libNDFalcon libboost
 